@@ -0,0 +1,178 @@
+#include "bank_system.h"
+#include "auth.h"
+
+/* Number of mixing rounds applied to every PIN hash */
+#define AUTH_HASH_ROUNDS 64
+
+/* One slot per possible ID */
+typedef struct{
+    uint64_t pin_hash;
+    long offset;            /* record position in the accounts file */
+    time_t locked_until;
+    uint8_t failures;
+    bool used;
+} Auth_entry;
+
+/* Lockout record persisted per ID, so restarting the program does not reset it */
+typedef struct{
+    int64_t locked_until;
+    uint8_t failures;
+} Auth_lock;
+
+static Auth_entry auth_table[AUTH_TABLE_SIZE];
+static uint64_t auth_salt;
+static FILE *lockout_file;
+
+static uint64_t mix64(uint64_t x);
+static uint64_t hash_pin(uint16_t id, uint16_t pin);
+static bool hash_equal(uint64_t a, uint64_t b);
+static void new_salt();
+static void save_lock(uint16_t id);
+
+/****************************************************************************************************************************************/
+/*********************************************  Table management  ***********************************************************************/
+/****************************************************************************************************************************************/
+
+void auth_init(FILE *accounts){
+    Account a;
+    long pos;
+
+    if (auth_salt == 0) new_salt();
+
+    /* lockout counters survive a rebuild, only the account data is reloaded */
+    for (int i = 0; i < AUTH_TABLE_SIZE; i++) auth_remove(i);
+
+    rewind(accounts);
+    while ((pos = ftell(accounts)), fread(&a, sizeof(Account), 1, accounts) == 1) {
+        /* first record wins, same as the old linear login scan */
+        if (a.id < AUTH_TABLE_SIZE && !auth_table[a.id].used)
+            auth_set_pin(a.id, a.pin, pos);
+    }
+}
+void auth_set_pin(uint16_t id, uint16_t pin, long offset){
+    if (id >= AUTH_TABLE_SIZE) return;
+
+    Auth_entry *e = &auth_table[id];
+    e->pin_hash = hash_pin(id, pin);
+    if (offset >= 0) e->offset = offset;
+    e->used = true;
+}
+void auth_remove(uint16_t id){
+    if (id >= AUTH_TABLE_SIZE) return;
+    auth_table[id].used = false;
+    auth_table[id].pin_hash = 0;
+}
+void auth_open_lockouts(const char *path){
+    lockout_file = fopen(path, "rb+");
+    if (lockout_file == NULL) lockout_file = fopen(path, "wb+");
+    if (lockout_file == NULL) {
+        perror("Failed to open or create lockout file, lockouts kept in memory only");
+        return;
+    }
+
+    /* one fixed-size slot per ID, read in a single pass at startup */
+    Auth_lock l;
+    for (int id = 0; id < AUTH_TABLE_SIZE && fread(&l, sizeof(l), 1, lockout_file) == 1; id++) {
+        auth_table[id].locked_until = (time_t)l.locked_until;
+        auth_table[id].failures = l.failures;
+    }
+}
+void auth_close(){
+    if (lockout_file) fclose(lockout_file);
+    lockout_file = NULL;
+}
+bool auth_exists(uint16_t id){
+    return id < AUTH_TABLE_SIZE && auth_table[id].used;
+}
+
+/****************************************************************************************************************************************/
+/***********************************************  Verification  *************************************************************************/
+/****************************************************************************************************************************************/
+
+Auth_result_t auth_login(uint16_t id, uint16_t pin, long *offset){
+    if (id >= AUTH_TABLE_SIZE) return AUTH_UNKNOWN_ID;
+
+    Auth_entry *e = &auth_table[id];
+    time_t now = time(NULL);
+
+    /* locked IDs are rejected before anything else is done */
+    if (e->locked_until > now) return AUTH_LOCKED;
+    if (e->locked_until != 0) {
+        e->locked_until = 0;
+        e->failures = 0;
+        save_lock(id);
+    }
+
+    /* hash even for unknown IDs so both paths cost the same */
+    bool match = hash_equal(hash_pin(id, pin), e->pin_hash);
+
+    if (e->used && match) {
+        if (e->failures != 0) {
+            e->failures = 0;
+            save_lock(id);
+        }
+        if (offset) *offset = e->offset;
+        return AUTH_OK;
+    }
+
+    /* unknown IDs are counted too, so probing for IDs gets locked as well */
+    if (++e->failures >= AUTH_MAX_FAILURES) e->locked_until = now + AUTH_LOCK_SECONDS;
+    save_lock(id);
+
+    return e->used ? AUTH_WRONG_PIN : AUTH_UNKNOWN_ID;
+}
+bool auth_check_pin(uint16_t id, uint16_t pin){
+    if (id >= AUTH_TABLE_SIZE) return false;
+    return auth_table[id].used && hash_equal(hash_pin(id, pin), auth_table[id].pin_hash);
+}
+
+/****************************************************************************************************************************************/
+/********************************************  Helper functions  ************************************************************************/
+/****************************************************************************************************************************************/
+
+/* splitmix64 finalizer */
+uint64_t mix64(uint64_t x){
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/* Salted hash of ID + PIN */
+uint64_t hash_pin(uint16_t id, uint16_t pin){
+    uint64_t h = auth_salt ^ (((uint64_t)id << 16) | pin);
+    for (int i = 0; i < AUTH_HASH_ROUNDS; i++) h = mix64(h + auth_salt);
+    return h;
+}
+
+/* Compare two hashes without an early exit */
+bool hash_equal(uint64_t a, uint64_t b){
+    volatile uint8_t diff = 0;
+    for (int i = 0; i < 8; i++) diff |= (uint8_t)((a >> (i * 8)) ^ (b >> (i * 8)));
+    return diff == 0;
+}
+
+/* Random salt, generated once per run */
+void new_salt(){
+    uint64_t seed = (uint64_t)time(NULL);
+    seed ^= (uint64_t)clock() << 32;
+    seed ^= (uint64_t)(uintptr_t)&seed;
+    seed ^= (uint64_t)rand() << 16;
+    auth_salt = mix64(seed) | 1;
+}
+
+/* Write the lockout slot of one ID */
+void save_lock(uint16_t id){
+    if (lockout_file == NULL) return;
+
+    Auth_lock l;
+    memset(&l, 0, sizeof(l));
+    l.locked_until = (int64_t)auth_table[id].locked_until;
+    l.failures = auth_table[id].failures;
+
+    fseek(lockout_file, (long)id * (long)sizeof(l), SEEK_SET);
+    fwrite(&l, sizeof(l), 1, lockout_file);
+    fflush(lockout_file);
+}
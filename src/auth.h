@@ -0,0 +1,41 @@
+#ifndef AUTH_H
+#define AUTH_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/* IDs are read as four-digit integers, so the table is indexed directly by ID */
+#define AUTH_TABLE_SIZE 10000
+/* Consecutive wrong PINs allowed per ID before it gets locked */
+#define AUTH_MAX_FAILURES 5
+/* How long a locked ID is rejected (seconds) */
+#define AUTH_LOCK_SECONDS 300
+
+/* Result of a login attempt */
+typedef enum{
+    AUTH_OK,
+    AUTH_UNKNOWN_ID,
+    AUTH_WRONG_PIN,
+    AUTH_LOCKED
+} Auth_result_t;
+
+/* Rebuild the in-memory PIN table from the accounts file */
+void auth_init(FILE *accounts);
+/* Load persisted failure counters / lockouts, must be called before any login */
+void auth_open_lockouts(const char *path);
+/* Close the lockout file */
+void auth_close();
+/* Store (or replace) the PIN of an ID; offset is the record position in the accounts file, -1 keeps the old one */
+void auth_set_pin(uint16_t id, uint16_t pin, long offset);
+/* Forget an ID */
+void auth_remove(uint16_t id);
+/* True if an account with this ID is known */
+bool auth_exists(uint16_t id);
+/* Verify ID + PIN, counting failures per ID; on success offset receives the record position */
+Auth_result_t auth_login(uint16_t id, uint16_t pin, long *offset);
+/* Verify PIN of an already logged in ID, without touching the failure counters */
+bool auth_check_pin(uint16_t id, uint16_t pin);
+
+#endif
@@ -1,4 +1,6 @@
 #include "bank_system.h"
+#include "auth.h"
+#include "txlog.h"
 
 /* Box drawing characters (kept as numeric codes; console codepage matters) */
 #define LT 201 // "\u2554"
@@ -9,7 +11,6 @@
 #define V 186 // "\u2551"
 
 FILE *accounts_file;
-FILE *logs_file;
 State_t state;
 
 Account current_user;
@@ -32,9 +33,11 @@ void shutdown_app();
 uint8_t admin_menu();
 void list_accounts();
 void delete_account();
+void search_logs();
 
 static uint16_t read_integer(const char *prompt, uint16_t max_count);
 static double read_double(const char *prompt);
+static time_t read_datetime(const char *prompt, bool end_of_day);
 static void update_pin(uint16_t id, uint16_t new_pin);
 static void update_balance(uint16_t id, double amount);
 static void write_log(const char *format, ...);
@@ -129,6 +132,9 @@ void state_machine(){
                     state = CHANGE_PIN;
                     break;
                 case 4:
+                    state = SEARCH_LOGS;
+                    break;
+                case 5:
                     state = LOGOUT;
                     break;
                 default:
@@ -144,6 +150,10 @@ void state_machine(){
             delete_account();
             state = ADMIN_MENU;
             break;
+        case SEARCH_LOGS:
+            search_logs();
+            state = ADMIN_MENU;
+            break;
         default:
             break;
         }
@@ -175,13 +185,15 @@ void load_accounts(){
     /* Ensure admin account exists (ID 9999) */
     Account admin = {9999, "ADMIN", 9999, 0}; fwrite(&admin, sizeof(admin), 1, accounts_file);
     // Example: Account user1 = {1000, "User1", 1234, 169.6}; fwrite(&user1, sizeof(user1), 1, accounts_file);
+    fflush(accounts_file);
+
+    /* Build the in-memory PIN table once, logins no longer scan the file */
+    auth_init(accounts_file);
+    auth_open_lockouts("./logs/lockouts.dat");
 }
 void open_logs(){
-    logs_file = fopen("./logs/transactions.log", "a"); 
-    if (logs_file == NULL) {
-        perror("Failed to open or create log file");
-        exit(1);
-    }
+    /* Segmented log: ./logs/transactions.NNNNNN.log + sparse index transactions.idx */
+    txlog_open("./logs");
 }
 
 /****************************************************************************************************************************************/
@@ -211,27 +223,34 @@ int login(){
         }
 
         pin = read_integer("PIN", 9999);
-        bool id_found = false;
-        rewind(accounts_file);
-        while(fread(&current_user, sizeof(current_user), 1, accounts_file) == 1){
-            if(current_user.id == id){
-                id_found = true;
-                if(current_user.pin == pin) {
-                    if(id == 9999){
-                        write_log("ID:%d %s - successful login", current_user.id, current_user.name);
-                        return 2;
-                    }else{
-                        write_log("ID:%d - Successful login", current_user.id);
-                        return 1;
-                    }
-                }else {
-                    printf(" PIN does not match. Remaining attempts: %d\r\n\r\n", 2 - attempts);
-                    write_log("ID:%d - Wrong PIN", current_user.id);
-                    break;
+        long offset;
+        switch(auth_login(id, pin, &offset)){
+            case AUTH_OK:
+                /* only a successful login touches the accounts file */
+                fseek(accounts_file, offset, SEEK_SET);
+                if(fread(&current_user, sizeof(current_user), 1, accounts_file) != 1){
+                    perror("Failed to read account");
+                    return 0;
                 }
-            }
+                if(id == 9999){
+                    write_log("ID:%d %s - successful login", current_user.id, current_user.name);
+                    return 2;
+                }else{
+                    write_log("ID:%d - Successful login", current_user.id);
+                    return 1;
+                }
+            case AUTH_WRONG_PIN:
+                printf(" PIN does not match. Remaining attempts: %d\r\n\r\n", 2 - attempts);
+                write_log("ID:%d - Wrong PIN", id);
+                break;
+            case AUTH_LOCKED:
+                printf(" Account is temporarily locked. Remaining attempts: %d\r\n\r\n", 2 - attempts);
+                write_log("ID:%d - Login rejected, account locked", id);
+                break;
+            default:
+                printf(" ID not found. Remaining attempts: %d\r\n\r\n", 2 - attempts);
+                break;
         }
-        if(!id_found) printf(" ID not found. Remaining attempts: %d\r\n\r\n", 2 - attempts);
         attempts++;
     }
     return 0;
@@ -250,15 +269,7 @@ void create_account(){
     bool id_exists = true;
     while(id_exists){
         id = read_integer("ID", 9997);
-        id_exists = false;
-
-        rewind(accounts_file);
-        while(fread(&new_user, sizeof(new_user), 1, accounts_file) == 1){
-            if(new_user.id == id) {
-                id_exists = true;
-                break;
-            }
-        }
+        id_exists = auth_exists(id);
         if(id_exists) printf(" Entered ID already exists. Enter another.\r\n\r\n");
         else new_user.id = id;
     }
@@ -282,8 +293,11 @@ void create_account(){
         }
     }
     new_user.balance = 0;
+    fseek(accounts_file, 0, SEEK_END);
+    long offset = ftell(accounts_file);
     fwrite(&new_user, sizeof(new_user), 1, accounts_file);
     fflush(accounts_file);
+    auth_set_pin(new_user.id, new_user.pin, offset);
 
     printf(" Account successfully created.\r\n\r\n");
     write_log("ID:%d - New account created", new_user.id);
@@ -361,7 +375,7 @@ void change_pin(){
 
     while(attempts < 3){
         pin = read_integer("PIN", 9999);
-        if(pin == current_user.pin){
+        if(auth_check_pin(current_user.id, pin)){
             verified = true;
             break;
         }else{
@@ -407,13 +421,14 @@ void logout(){
     write_log("ID:%d - Successfully logged out", current_user.id);
 }
 void shutdown_app(){
-    if(accounts_file) fclose(accounts_file);
-    if(logs_file) fclose(logs_file);
-
     if (current_user.id != 0)
         write_log("ID:%d - Application closed", current_user.id);
     else
         write_log("Application closed without login");
+
+    if(accounts_file) fclose(accounts_file);
+    txlog_close();
+    auth_close();
 }
 
 /****************************************************************************************************************************************/
@@ -426,13 +441,14 @@ uint8_t admin_menu(){
     print_table_text(40, "1. List accounts             ");
     print_table_text(40, "2. Delete account            ");
     print_table_text(40, "3. Change PIN                ");
-    print_table_text(40, "4. Logout                    ");
-    print_table_text(40, "5. Exit program              ");
+    print_table_text(40, "4. Search logs               ");
+    print_table_text(40, "5. Logout                    ");
+    print_table_text(40, "6. Exit program              ");
     print_table_bottom(40);
     
     uint8_t choice = (uint8_t)read_integer("Choose option", 9);
-    while (choice < 1 || choice > 5){
-        printf(" Choice must be between 1 and 5. Choose again.\r\n\r\n");
+    while (choice < 1 || choice > 6){
+        printf(" Choice must be between 1 and 6. Choose again.\r\n\r\n");
         choice = (uint8_t)read_integer("Choose option", 9);
     }
     
@@ -521,10 +537,28 @@ void delete_account(){
         perror("Failed to reopen ucty.dat");
         exit(1);
     }
+    auth_init(accounts_file); /* record offsets have shifted */
 
     write_log("ID:%d %s - Account with ID: %d successfully deleted", current_user.id, current_user.name, ID);
     printf(" Account with ID %d was successfully deleted.\r\n\r\n", ID);
 }
+void search_logs(){
+    print_table_top(40);
+    print_table_text(40, "Search logs");
+    print_table_text(40, " ");
+    print_table_text(40, "YYYY-MM-DD or YYYY-MM-DD HH:MM");
+    print_table_bottom(40);
+
+    time_t from = read_datetime("From", false);
+    time_t to = read_datetime("To", true);
+    printf("\r\n");
+
+    long count = txlog_query(from, to, stdout);
+    if(count == 0) printf(" No log entries found.\r\n\r\n");
+    else printf("\r\n Found %ld entries.\r\n\r\n", count);
+
+    write_log("ID:%d %s - Searched logs", current_user.id, current_user.name);
+}
 
 /****************************************************************************************************************************************/
 /********************************************  Helper functions  ************************************************************************/
@@ -571,6 +605,33 @@ double read_double(const char *prompt){
     }
 }
 
+/* Read date (and optional time) from stdin; a date alone means start or end of that day */
+time_t read_datetime(const char *prompt, bool end_of_day){
+    char line[64];
+    int year, month, day, hour = 0, minute = 0;
+    while (1) {
+        printf(" %s: ", prompt);
+        fflush(stdout);
+        if (fgets(line, sizeof(line), stdin) != NULL) {
+            int n = sscanf(line, "%d-%d-%d %d:%d", &year, &month, &day, &hour, &minute);
+            if ((n == 3 || n == 5) && year >= 1970 && month >= 1 && month <= 12 && day >= 1 && day <= 31
+                && hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59) {
+                struct tm tm_info = {0};
+                tm_info.tm_year = year - 1900;
+                tm_info.tm_mon = month - 1;
+                tm_info.tm_mday = day;
+                tm_info.tm_hour = (n == 3 && end_of_day) ? 23 : hour;
+                tm_info.tm_min = (n == 3 && end_of_day) ? 59 : minute;
+                tm_info.tm_sec = end_of_day ? 59 : 0;
+                tm_info.tm_isdst = -1;
+                time_t t = mktime(&tm_info);
+                if (t != (time_t)-1) return t;
+            }
+        }
+        printf(" %s must be a date YYYY-MM-DD or YYYY-MM-DD HH:MM. Enter %s again.\r\n", prompt, prompt);
+    }
+}
+
 /* Update PIN in the accounts file for given ID */
 void update_pin(uint16_t id, uint16_t new_pin){
     rewind(accounts_file);
@@ -587,6 +648,7 @@ void update_pin(uint16_t id, uint16_t new_pin){
             fflush(accounts_file);
         }
     }
+    auth_set_pin(id, new_pin, -1);
 }
 
 /* Update balance in the accounts file for given ID */
@@ -607,23 +669,12 @@ void update_balance(uint16_t id, double amount){
     }
 }
 
-/* Write timestamped entry to log file */
+/* Write timestamped entry to the segmented log */
 void write_log(const char *format, ...){
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
-    char timestr[30];
-
-    strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", tm_info);
-
-    fprintf(logs_file, "[%s] ", timestr);
-
     va_list args;
     va_start(args, format);
-    vfprintf(logs_file, format, args);
+    txlog_vwrite(format, args);
     va_end(args);
-
-    fprintf(logs_file, "\n");
-    fflush(logs_file);
 }
 
 /* Simple ASCII/box printing helpers */
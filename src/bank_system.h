@@ -23,7 +23,8 @@ typedef enum{
     EXIT_APP,
     ADMIN_MENU,
     ACCOUNTS,
-    DELETE_ACCOUNT
+    DELETE_ACCOUNT,
+    SEARCH_LOGS
 } State_t;
 
 /* Account structure stored in ucty.dat */
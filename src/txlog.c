@@ -0,0 +1,465 @@
+#include "bank_system.h"
+#include "txlog.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* LZSS parameters for sealed segments: 12-bit offset, 4-bit length */
+#define LZ_WINDOW 4096
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH 18
+#define LZ_HASH_SIZE 4096
+#define LZ_MAX_CHAIN 32
+#define LZ_HEADER_SIZE 8
+
+/* Sparse index entry, stored as is in transactions.idx */
+typedef struct{
+    int64_t time;           /* timestamp of the entry at offset */
+    uint32_t segment;
+    uint32_t offset;        /* byte offset of the entry in the uncompressed segment */
+} Txlog_index;
+
+static char log_dir[256];
+static FILE *active_file;
+static FILE *index_file;
+static uint32_t active_segment;
+static long active_size;
+static long last_index_offset;
+static int active_day;
+
+static Txlog_index *index_entries;
+static size_t index_count;
+static size_t index_capacity;
+
+static void segment_path(char *buf, size_t size, uint32_t segment, const char *ext);
+static bool file_exists(const char *path);
+static bool push_index(Txlog_index e);
+static void add_index(time_t t, uint32_t segment, long offset);
+static void open_segment(uint32_t segment);
+static void rotate();
+static int day_of(time_t t);
+static char *load_segment(uint32_t segment, long start, size_t *len);
+static void compress_segment(uint32_t segment);
+static void compress_in_background(uint32_t segment);
+static bool lz_compress(const uint8_t *in, size_t n, uint8_t *out, size_t *out_len);
+static bool lz_decompress(const uint8_t *in, size_t n, uint8_t *out, size_t raw_len);
+
+/****************************************************************************************************************************************/
+/*********************************************  Open / close  ***************************************************************************/
+/****************************************************************************************************************************************/
+
+void txlog_open(const char *dir){
+    char path[300];
+    Txlog_index e;
+
+    snprintf(log_dir, sizeof(log_dir), "%s", dir);
+
+    /* load the sparse index, it is small enough to keep in memory */
+    snprintf(path, sizeof(path), "%s/transactions.idx", log_dir);
+    FILE *f = fopen(path, "rb");
+    if (f != NULL) {
+        while (fread(&e, sizeof(e), 1, f) == 1 && push_index(e));
+        fclose(f);
+    }
+    index_file = fopen(path, "ab");
+    if (index_file == NULL) {
+        perror("Failed to open or create log index");
+        exit(1);
+    }
+
+    /* continue the last segment unless it has already been sealed */
+    active_segment = index_count ? index_entries[index_count - 1].segment : 1;
+    segment_path(path, sizeof(path), active_segment, "lz");
+    if (file_exists(path)) active_segment++;
+    open_segment(active_segment);
+
+    last_index_offset = 0;
+    active_day = -1;
+    for (size_t i = index_count; i > 0; i--) {
+        if (index_entries[i - 1].segment == active_segment) {
+            last_index_offset = (long)index_entries[i - 1].offset;
+            active_day = day_of((time_t)index_entries[i - 1].time);
+            break;
+        }
+    }
+
+    /* finish compressions interrupted by a previous exit */
+    for (uint32_t s = active_segment - 1; s > 0; s--) {
+        char lz[300];
+        segment_path(path, sizeof(path), s, "log");
+        if (!file_exists(path)) break;
+        segment_path(lz, sizeof(lz), s, "lz");
+        if (file_exists(lz)) remove(path);
+        else compress_in_background(s);
+    }
+}
+void txlog_close(){
+    if (active_file) fclose(active_file);
+    if (index_file) fclose(index_file);
+    active_file = NULL;
+    index_file = NULL;
+}
+
+/****************************************************************************************************************************************/
+/************************************************  Writing  *****************************************************************************/
+/****************************************************************************************************************************************/
+
+void txlog_vwrite(const char *format, va_list args){
+    if (active_file == NULL) return;
+
+    time_t t = time(NULL);
+    struct tm *tm_info = localtime(&t);
+    char timestr[30];
+    int day = (tm_info->tm_year + 1900) * 1000 + tm_info->tm_yday;
+
+    strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", tm_info);
+
+    if (active_size > 0 && (active_size >= TXLOG_SEGMENT_MAX || day != active_day)) rotate();
+    active_day = day;
+
+    if (active_size == 0 || active_size - last_index_offset >= TXLOG_INDEX_STRIDE)
+        add_index(t, active_segment, active_size);
+
+    int n;
+    if ((n = fprintf(active_file, "[%s] ", timestr)) > 0) active_size += n;
+    if ((n = vfprintf(active_file, format, args)) > 0) active_size += n;
+    if ((n = fprintf(active_file, "\n")) > 0) active_size += n;
+    fflush(active_file);
+}
+
+/****************************************************************************************************************************************/
+/************************************************  Query  *******************************************************************************/
+/****************************************************************************************************************************************/
+
+long txlog_query(time_t from, time_t to, FILE *out){
+    if (index_count == 0 || from > to) return 0;
+
+    /* timestamps are fixed width, so they compare as plain strings */
+    char from_str[30], to_str[30];
+    strftime(from_str, sizeof(from_str), "%Y-%m-%d %H:%M:%S", localtime(&from));
+    strftime(to_str, sizeof(to_str), "%Y-%m-%d %H:%M:%S", localtime(&to));
+
+    /* last index entry older than from, everything before it can be skipped */
+    size_t lo = 0, hi = index_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((time_t)index_entries[mid].time < from) lo = mid;
+        else hi = mid;
+    }
+
+    uint32_t segment = index_entries[lo].segment;
+    long start = (long)index_entries[lo].offset;
+    long count = 0;
+
+    for (; segment <= active_segment; segment++, start = 0) {
+        size_t len;
+        char *data = load_segment(segment, start, &len);
+        if (data == NULL) continue;
+
+        char *p = data, *end = data + len;
+        while (p < end) {
+            char *nl = memchr(p, '\n', end - p);
+            size_t line_len = nl ? (size_t)(nl - p) : (size_t)(end - p);
+
+            if (line_len > 20 && p[0] == '[') {
+                if (strncmp(p + 1, to_str, 19) > 0) {
+                    free(data);
+                    return count;
+                }
+                if (strncmp(p + 1, from_str, 19) >= 0) {
+                    fprintf(out, " %.*s\r\n", (int)line_len, p);
+                    count++;
+                }
+            }
+            p += line_len + 1;
+        }
+        free(data);
+    }
+    return count;
+}
+
+/****************************************************************************************************************************************/
+/********************************************  Helper functions  ************************************************************************/
+/****************************************************************************************************************************************/
+
+/* Path of a segment file, e.g. ./logs/transactions.000001.log */
+void segment_path(char *buf, size_t size, uint32_t segment, const char *ext){
+    snprintf(buf, size, "%s/transactions.%06u.%s", log_dir, (unsigned)segment, ext);
+}
+
+bool file_exists(const char *path){
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return false;
+    fclose(f);
+    return true;
+}
+
+/* Append entry to the in-memory index */
+bool push_index(Txlog_index e){
+    if (index_count == index_capacity) {
+        size_t capacity = index_capacity ? index_capacity * 2 : 256;
+        Txlog_index *grown = realloc(index_entries, capacity * sizeof(Txlog_index));
+        if (grown == NULL) return false;
+        index_entries = grown;
+        index_capacity = capacity;
+    }
+    index_entries[index_count++] = e;
+    return true;
+}
+
+/* Append entry to the in-memory and on-disk index */
+void add_index(time_t t, uint32_t segment, long offset){
+    Txlog_index e = {(int64_t)t, segment, (uint32_t)offset};
+
+    if (!push_index(e)) return;
+    last_index_offset = offset;
+
+    fwrite(&e, sizeof(e), 1, index_file);
+    fflush(index_file);
+}
+
+/* Open segment for appending; binary mode keeps byte offsets exact */
+void open_segment(uint32_t segment){
+    char path[300];
+    segment_path(path, sizeof(path), segment, "log");
+
+    active_file = fopen(path, "ab");
+    if (active_file == NULL) {
+        perror("Failed to open or create log file");
+        exit(1);
+    }
+    fseek(active_file, 0, SEEK_END);
+    active_size = ftell(active_file);
+}
+
+/* Seal the active segment and start the next one */
+void rotate(){
+    fclose(active_file);
+    compress_in_background(active_segment);
+
+    active_segment++;
+    open_segment(active_segment);
+    last_index_offset = 0;
+}
+
+int day_of(time_t t){
+    struct tm *tm_info = localtime(&t);
+    return (tm_info->tm_year + 1900) * 1000 + tm_info->tm_yday;
+}
+
+/* Read segment contents from start on, plain or compressed; caller frees */
+char *load_segment(uint32_t segment, long start, size_t *len){
+    char path[300];
+    FILE *f;
+    long size;
+
+    segment_path(path, sizeof(path), segment, "log");
+    if ((f = fopen(path, "rb")) != NULL) {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        if (start > size) start = size;
+        fseek(f, start, SEEK_SET);
+
+        char *data = malloc(size - start + 1);
+        if (data == NULL) { fclose(f); return NULL; }
+        *len = fread(data, 1, size - start, f);
+        data[*len] = '\0';
+        fclose(f);
+        return data;
+    }
+
+    segment_path(path, sizeof(path), segment, "lz");
+    if ((f = fopen(path, "rb")) == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    rewind(f);
+
+    uint8_t *packed = malloc(size > 0 ? size : 1);
+    if (packed == NULL || size < LZ_HEADER_SIZE || fread(packed, 1, size, f) != (size_t)size || memcmp(packed, "FVLZ", 4) != 0) {
+        free(packed);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    size_t raw_len = (size_t)packed[4] | (size_t)packed[5] << 8 | (size_t)packed[6] << 16 | (size_t)packed[7] << 24;
+    char *data = malloc(raw_len + 1);
+    if (data == NULL || !lz_decompress(packed + LZ_HEADER_SIZE, size - LZ_HEADER_SIZE, (uint8_t *)data, raw_len)) {
+        free(packed);
+        free(data);
+        return NULL;
+    }
+    free(packed);
+
+    if ((size_t)start > raw_len) start = (long)raw_len;
+    memmove(data, data + start, raw_len - start);
+    *len = raw_len - start;
+    data[*len] = '\0';
+    return data;
+}
+
+/* Replace segment .log by .lz; the .log is only removed once the .lz is complete */
+void compress_segment(uint32_t segment){
+    char log_path[300], lz_path[300], tmp_path[300];
+    segment_path(log_path, sizeof(log_path), segment, "log");
+    segment_path(lz_path, sizeof(lz_path), segment, "lz");
+    segment_path(tmp_path, sizeof(tmp_path), segment, "tmp");
+
+    FILE *f = fopen(log_path, "rb");
+    if (f == NULL) return;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+
+    uint8_t *raw = malloc(size > 0 ? size : 1);
+    uint8_t *packed = malloc(LZ_HEADER_SIZE + size + size / 8 + 2);
+    size_t packed_len;
+    bool ok = raw != NULL && packed != NULL
+        && fread(raw, 1, size, f) == (size_t)size
+        && lz_compress(raw, size, packed + LZ_HEADER_SIZE, &packed_len);
+    fclose(f);
+
+    if (ok) {
+        memcpy(packed, "FVLZ", 4);
+        packed[4] = size & 0xFF;
+        packed[5] = (size >> 8) & 0xFF;
+        packed[6] = (size >> 16) & 0xFF;
+        packed[7] = (size >> 24) & 0xFF;
+
+        FILE *out = fopen(tmp_path, "wb");
+        ok = out != NULL && fwrite(packed, 1, LZ_HEADER_SIZE + packed_len, out) == LZ_HEADER_SIZE + packed_len;
+        if (out) ok = (fclose(out) == 0) && ok;
+    }
+    if (ok) {
+        remove(lz_path);
+        if (rename(tmp_path, lz_path) == 0) remove(log_path);
+    }else {
+        remove(tmp_path);
+    }
+    free(raw);
+    free(packed);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI compress_worker(LPVOID arg){
+    compress_segment(*(uint32_t *)arg);
+    free(arg);
+    return 0;
+}
+#else
+static void *compress_worker(void *arg){
+    compress_segment(*(uint32_t *)arg);
+    free(arg);
+    return NULL;
+}
+#endif
+
+/* Compress a sealed segment on a worker thread, inline if no thread can be started */
+void compress_in_background(uint32_t segment){
+    uint32_t *arg = malloc(sizeof(*arg));
+    if (arg != NULL) {
+        *arg = segment;
+#ifdef _WIN32
+        HANDLE thread = CreateThread(NULL, 0, compress_worker, arg, 0, NULL);
+        if (thread != NULL) { CloseHandle(thread); return; }
+#else
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, compress_worker, arg) == 0) { pthread_detach(thread); return; }
+#endif
+        free(arg);
+    }
+    compress_segment(segment);
+}
+
+/* LZSS: flag byte per 8 items, bit set = literal byte, bit clear = 2 byte match */
+bool lz_compress(const uint8_t *in, size_t n, uint8_t *out, size_t *out_len){
+    int32_t *head = malloc(LZ_HASH_SIZE * sizeof(int32_t));
+    int32_t *prev = malloc((n > 0 ? n : 1) * sizeof(int32_t));
+    if (head == NULL || prev == NULL) {
+        free(head);
+        free(prev);
+        return false;
+    }
+    for (int i = 0; i < LZ_HASH_SIZE; i++) head[i] = -1;
+
+    size_t ip = 0, op = 0, flag_pos = 0;
+    int bit = 8;
+
+    while (ip < n) {
+        if (bit == 8) {
+            flag_pos = op++;
+            out[flag_pos] = 0;
+            bit = 0;
+        }
+
+        size_t best_len = 0, best_off = 0;
+        size_t max = n - ip < LZ_MAX_MATCH ? n - ip : LZ_MAX_MATCH;
+        if (max >= LZ_MIN_MATCH) {
+            uint32_t h = ((in[ip] << 8) ^ (in[ip + 1] << 4) ^ in[ip + 2]) & (LZ_HASH_SIZE - 1);
+            int32_t cand = head[h];
+            for (int chain = 0; cand >= 0 && ip - cand < LZ_WINDOW && chain < LZ_MAX_CHAIN; chain++) {
+                size_t len = 0;
+                while (len < max && in[cand + len] == in[ip + len]) len++;
+                if (len > best_len) {
+                    best_len = len;
+                    best_off = ip - cand;
+                    if (len == max) break;
+                }
+                cand = prev[cand];
+            }
+        }
+
+        size_t step;
+        if (best_len >= LZ_MIN_MATCH) {
+            out[op++] = (best_off >> 4) & 0xFF;
+            out[op++] = ((best_off & 0x0F) << 4) | (best_len - LZ_MIN_MATCH);
+            step = best_len;
+        }else {
+            out[flag_pos] |= 1 << bit;
+            out[op++] = in[ip];
+            step = 1;
+        }
+        bit++;
+
+        /* remember every position covered, so later matches can refer to it */
+        for (; step > 0; step--, ip++) {
+            if (ip + LZ_MIN_MATCH <= n) {
+                uint32_t h = ((in[ip] << 8) ^ (in[ip + 1] << 4) ^ in[ip + 2]) & (LZ_HASH_SIZE - 1);
+                prev[ip] = head[h];
+                head[h] = (int32_t)ip;
+            }
+        }
+    }
+
+    free(head);
+    free(prev);
+    *out_len = op;
+    return true;
+}
+
+bool lz_decompress(const uint8_t *in, size_t n, uint8_t *out, size_t raw_len){
+    size_t ip = 0, op = 0;
+
+    while (op < raw_len) {
+        if (ip >= n) return false;
+        uint8_t flags = in[ip++];
+
+        for (int bit = 0; bit < 8 && op < raw_len; bit++) {
+            if (flags & (1 << bit)) {
+                if (ip >= n) return false;
+                out[op++] = in[ip++];
+            }else {
+                if (ip + 2 > n) return false;
+                size_t off = ((size_t)in[ip] << 4) | (in[ip + 1] >> 4);
+                size_t len = (in[ip + 1] & 0x0F) + LZ_MIN_MATCH;
+                ip += 2;
+                if (off == 0 || off > op || op + len > raw_len) return false;
+                for (; len > 0; len--, op++) out[op] = out[op - off];
+            }
+        }
+    }
+    return true;
+}
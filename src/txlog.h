@@ -0,0 +1,24 @@
+#ifndef TXLOG_H
+#define TXLOG_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Active segment is sealed once it reaches this size (bytes) or the day changes */
+#define TXLOG_SEGMENT_MAX (256 * 1024)
+/* A sparse index entry is written at least every this many bytes of a segment */
+#define TXLOG_INDEX_STRIDE 4096
+
+/* Open (or continue) the segmented transaction log in the given directory */
+void txlog_open(const char *dir);
+/* Close the active segment */
+void txlog_close();
+/* Append one timestamped entry, rotating the segment when needed */
+void txlog_vwrite(const char *format, va_list args);
+/* Print all entries with from <= timestamp <= to to out, returns the number of entries */
+long txlog_query(time_t from, time_t to, FILE *out);
+
+#endif